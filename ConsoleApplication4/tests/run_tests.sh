@@ -0,0 +1,110 @@
+#!/bin/bash
+# run_tests.sh : runs the scripted command files in this folder against a build of
+# ConsoleApplication4 and compares what it prints with the expected output.
+#
+# usage: run_tests.sh path/to/ConsoleApplication4[.exe]
+#
+# A case is a set of files sharing a name:
+#   name.N.dat     command file for step N, copied to prog_5_dat_file.dat; steps run
+#                  in order in one scratch folder, so later steps see the journal and
+#                  snapshot files earlier ones wrote
+#   name.N.gen     awk program whose output is the command file for step N, in place
+#                  of name.N.dat, for inputs too big to keep
+#   name.N.out     expected output of step N (optional)
+#   name.args      extra arguments for every step (optional)
+#   name.ref       arguments for a second run of every step whose output must be the
+#                  same, for output too big to keep; only for steps that write no files
+#   name.in.F      copied into the scratch folder as F before the first step, for
+#                  files the program reads that no step writes, such as old snapshots
+#   name.limit     largest file in KiB the program may write, for every step (optional),
+#                  so a journal write comes up short; SIGXFSZ is ignored for it
+#   name.file.F    after the last step, file F must hold exactly these lines
+#   name.within.F  after the last step, file F must hold a subsequence of these lines,
+#                  for reports that run while commands change the inventory
+# Output is compared ignoring carriage returns, so Windows builds pass too.
+
+app=$1
+if [ -z "$app" ] || [ ! -x "$app" ]; then
+	echo "usage: $0 path/to/ConsoleApplication4" >&2
+	exit 2
+fi
+app=$(cd "$(dirname "$app")" && pwd)/$(basename "$app")
+here=$(cd "$(dirname "$0")" && pwd)
+scratch=$(mktemp -d)
+trap 'rm -rf "$scratch"' EXIT
+failed=0
+
+subsequence() {
+	# true if every line of $1 appears in $2, in the same order
+	awk 'BEGIN { i = 0 } { sub(/\r$/, "") } NR == FNR { want[n++] = $0; next } i < n && $0 == want[i] { i++ } END { exit (i < n) }' "$1" "$2"
+}
+
+for first in "$here"/*.1.dat "$here"/*.1.gen; do
+	[ -f "$first" ] || continue
+	name=$(basename "${first%.*}" .1)
+	work="$scratch/$name"
+	args=
+	ref=
+	limit=unlimited
+	ok=1
+	mkdir "$work"
+	[ -f "$here/$name.args" ] && args=$(cat "$here/$name.args")
+	[ -f "$here/$name.limit" ] && limit=$(cat "$here/$name.limit")
+	[ -f "$here/$name.ref" ] && ref=$(cat "$here/$name.ref")
+	for input in "$here/$name".in.*; do
+		[ -f "$input" ] && cp "$input" "$work/${input##*.in.}"
+	done
+
+	for dat in $(ls "$here/$name".*.dat "$here/$name".*.gen 2> /dev/null | sort -t. -k2 -n); do
+		step=$(basename "${dat%.*}")
+		if [ "${dat##*.}" = gen ]; then
+			awk -f "$dat" > "$work/prog_5_dat_file.dat"
+		else
+			cp "$dat" "$work/prog_5_dat_file.dat"
+		fi
+		# output goes through cat, so the limit only reaches files the program writes itself
+		(cd "$work" && ulimit -f "$limit" && trap '' XFSZ && "$app" $args < /dev/null 2>&1) | cat > "$work/$step.txt"
+		status=${PIPESTATUS[0]}
+		if [ $status != 0 ]; then
+			echo "FAIL $step: exit status $status"
+			ok=0
+		elif [ -f "$here/$step.out" ] && ! diff -q --strip-trailing-cr "$here/$step.out" "$work/$step.txt" > /dev/null; then
+			echo "FAIL $step: output differs"
+			diff --strip-trailing-cr "$here/$step.out" "$work/$step.txt" | head -10
+			ok=0
+		fi
+		if [ -n "$ref" ] && [ $ok = 1 ]; then
+			(cd "$work" && "$app" $ref < /dev/null > "$step.ref.txt" 2>&1)
+			if ! cmp -s "$work/$step.txt" "$work/$step.ref.txt"; then
+				echo "FAIL $step: output differs from a run with $ref"
+				diff "$work/$step.ref.txt" "$work/$step.txt" | head -10
+				ok=0
+			fi
+		fi
+	done
+
+	for expected in "$here/$name".file.*; do
+		[ -f "$expected" ] || continue
+		file=${expected##*.file.}
+		if [ ! -f "$work/$file" ] || ! diff -q --strip-trailing-cr "$expected" "$work/$file" > /dev/null; then
+			echo "FAIL $name: $file differs from $(basename "$expected")"
+			ok=0
+		fi
+	done
+
+	for within in "$here/$name".within.*; do
+		[ -f "$within" ] || continue
+		file=${within##*.within.}
+		if [ ! -f "$work/$file" ] || ! subsequence "$work/$file" "$within"; then
+			echo "FAIL $name: $file is not a subsequence of $(basename "$within")"
+			ok=0
+		fi
+	done
+
+	if [ $ok = 1 ]; then
+		echo "ok   $name"
+	else
+		failed=1
+	fi
+done
+exit $failed